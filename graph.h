@@ -1,20 +1,59 @@
 #ifndef ASSIGNMENTS_DG_GRAPH_H_
 #define ASSIGNMENTS_DG_GRAPH_H_
 
+#include <cstddef>
+#include <deque>
+#include <functional>
 #include <iostream>
 #include <iterator>
 #include <map>
 #include <memory>
+#include <string>
 #include <tuple>
+#include <type_traits>
+#include <unordered_set>
 #include <vector>
 
 namespace gdwg {
 
+// Execution policies for Graph::ForEachEdge and Graph::ForEachNode.
+struct sequenced_policy {};
+struct parallel_policy {
+  unsigned threads = 0;  // 0 uses std::thread::hardware_concurrency()
+  std::size_t grain = 0;  // items per chunk; 0 picks one from the graph size
+};
+constexpr sequenced_policy seq{};
+constexpr parallel_policy par{};
+
+// Output formats for Graph::Export.
+//   kEdgeList: one "src dst weight" line per edge.
+//   kDot:      a Graphviz digraph, including nodes without edges.
+//   kBinary:   "GDWG" and a version byte, then for each node its value, a uint32 out-degree
+//              and that many (dst, weight) pairs. Trivially copyable values are written as
+//              raw bytes in host byte order, anything else as a uint32 length and its text.
+// Numbers in text are written with std::to_chars, so floating point values use the shortest
+// form that reads back exactly (0.1 + 0.2 is written as 0.30000000000000004).
+enum class export_format { kEdgeList, kDot, kBinary };
+
+namespace detail {
+
+// True when std::hash<T> is enabled, i.e. T can be hashed.
+template <typename T>
+constexpr bool kIsHashable = std::is_default_constructible_v<std::hash<T>>;
+
+}  // namespace detail
+
 template <typename N, typename E>
 class Graph {
  public:
   class const_iterator;
   class const_reverse_iterator;
+  class node_view;
+  class edge_view;
+  class weight_view;
+  class dfs_range;
+  class bfs_range;
+  class path_range;
   // ---------------------- Constructors ----------------------
 
   Graph<N, E>();
@@ -40,13 +79,64 @@ class Graph {
   void MergeReplace(const N& oldData, const N& newData);
   void Clear();
 
-  bool IsNode(const N& val);
+  bool IsNode(const N& val) const;
   bool IsConnected(const N& src, const N& dst);
   bool IsConnectedWeight(const N& src, const N& dst, const E& weight);
   std::vector<N> GetNodes() const;
   std::vector<N> GetConnected(const N& src);
   std::vector<E> GetWeights(const N& src, const N& dst);
 
+  // Views over the stored data; no copies are made. Invalidated by any mutation of the graph.
+  node_view Nodes() const;
+  edge_view OutEdges(const N& src) const;
+  edge_view InEdges(const N& dst) const;
+  weight_view Weights(const N& src, const N& dst) const;
+
+  // Lazy traversals that only do the work for the elements actually consumed, so breaking
+  // out of the loop early skips the rest. If prune(node) returns true the node is still
+  // yielded but the traversal does not continue through it. Paths yields each simple path
+  // from src to dst with at most maxLen edges.
+  dfs_range Dfs(const N& start, std::function<bool(const N&)> prune = nullptr) const;
+  bfs_range Bfs(const N& start, std::function<bool(const N&)> prune = nullptr) const;
+  path_range Paths(const N& src,
+                   const N& dst,
+                   std::size_t maxLen,
+                   std::function<bool(const N&)> prune = nullptr) const;
+
+  struct export_options {
+    export_format format = export_format::kEdgeList;
+    // Only nodes for which filter returns true, and edges between them, are written.
+    std::function<bool(const N&)> filter;
+    // If set, edges from a written node are checked against dstFilter instead of filter,
+    // so edges can lead to nodes that are not written themselves.
+    std::function<bool(const N&)> dstFilter;
+    // Chunks of nodes are formatted on policy.threads threads and written in node order;
+    // filter must then be safe to call concurrently.
+    parallel_policy policy{1, 0};
+  };
+
+  // Formats into large in-memory blocks and writes each block with a single os.write.
+  void Export(std::ostream& os, const export_options& options = {}) const;
+
+  // fn(src, dst, weight) / fn(node). The parallel overloads split the work into chunks of
+  // roughly equal edge (or node) count, so a single high-degree node is shared between
+  // threads, and idle threads pick up the next free chunk. fn must be safe to call
+  // concurrently; the first exception thrown by fn is rethrown once all threads finish.
+  template <typename F>
+  void ForEachEdge(sequenced_policy, F fn) const;
+  template <typename F>
+  void ForEachEdge(const parallel_policy& policy, F fn) const;
+  template <typename F>
+  void ForEachNode(sequenced_policy, F fn) const;
+  template <typename F>
+  void ForEachNode(const parallel_policy& policy, F fn) const;
+
+  // Order-independent hash of the nodes and edges, kept up to date by every mutation.
+  // Equal graphs always have equal fingerprints. Values whose type has no std::hash all hash
+  // the same, so if N or E is such a type the fingerprint only tells graphs apart by their
+  // remaining values and by node and edge counts. std::hash<Graph> is disabled unless both are.
+  std::size_t Fingerprint() const noexcept;
+
   const_iterator find(const N& src, const N& dst, const E& weight);
 
   bool erase(const N& src, const N& dst, const E& w);
@@ -63,20 +153,26 @@ class Graph {
 
   // ---------------------- Friends ----------------------
   friend bool operator==(const gdwg::Graph<N, E>& g1, const gdwg::Graph<N, E>& g2) {
-    return !(g1 != g2);
-  }
-  friend bool operator!=(const gdwg::Graph<N, E>& g1, const gdwg::Graph<N, E>& g2) {
-    auto g1Nodes = g1.GetNodes();
-    auto g2Nodes = g2.GetNodes();
-    if (g1Nodes.size() != g2Nodes.size()) {
-      return true;
+    if (g1.fingerprint_ != g2.fingerprint_ || g1.nodes_.size() != g2.nodes_.size()) {
+      return false;
     }
-    for (int i = 0; i < static_cast<int>(g2Nodes.size()); i++) {
-      if (g1Nodes[i] != g2Nodes[i]) {
-        return true;
+    for (auto it1 = g1.nodes_.begin(), it2 = g2.nodes_.begin(); it1 != g1.nodes_.end();
+         ++it1, ++it2) {
+      const auto& out1 = it1->second->outGoing_;
+      const auto& out2 = it2->second->outGoing_;
+      if (it1->first != it2->first || out1.size() != out2.size()) {
+        return false;
+      }
+      for (std::size_t i = 0; i < out1.size(); i++) {
+        if (*out1[i]->dst_ != *out2[i]->dst_ || *out1[i]->weight_ != *out2[i]->weight_) {
+          return false;
+        }
       }
     }
-    return false;
+    return true;
+  }
+  friend bool operator!=(const gdwg::Graph<N, E>& g1, const gdwg::Graph<N, E>& g2) {
+    return !(g1 == g2);
   }
 
   friend std::ostream& operator<<(std::ostream& os, const gdwg::Graph<N, E>& g) {
@@ -95,6 +191,12 @@ class Graph {
   struct Edge;
   struct Node;
   std::map<N, std::shared_ptr<Node>> nodes_;
+  std::size_t fingerprint_ = 0;
+
+  void CopyFrom(const Graph& other);
+  static std::size_t NodeHash(const N& val);
+  static std::size_t EdgeHash(const N& src, const N& dst, const E& w);
+  void ExportNode(std::string& buf, const Node& node, const export_options& options) const;
 
   struct Node {
     std::shared_ptr<N> val_;
@@ -114,10 +216,17 @@ class Graph {
     std::shared_ptr<N> src_;
     std::shared_ptr<N> dst_;
     std::shared_ptr<E> weight_;
-    Edge(std::shared_ptr<N> src, std::shared_ptr<N> dst, std::shared_ptr<E> weight) {
+    // Node that owns dst_, so traversals can step along an edge without a map lookup.
+    // Deleting a node deletes its edges, so this never dangles.
+    const Node* dstNode_;
+    Edge(std::shared_ptr<N> src,
+         std::shared_ptr<N> dst,
+         std::shared_ptr<E> weight,
+         const Node* dstNode) {
       src_ = src;
       dst_ = dst;
       weight_ = weight;
+      dstNode_ = dstNode;
     }
     friend bool operator==(const Edge& lhs, const Edge& rhs) {
       if (*lhs.dst_ != *rhs.dst_ || *lhs.src != *rhs.src_ || lhs.weight_ != rhs.weight_) {
@@ -286,10 +395,467 @@ class Graph {
 
     friend class Graph;
   };
+
+  class node_view {
+   public:
+    class iterator {
+     public:
+      using iterator_category = std::forward_iterator_tag;
+      using value_type = N;
+      using difference_type = std::ptrdiff_t;
+      using pointer = const N*;
+      using reference = const N&;
+
+      iterator() = default;
+
+      reference operator*() const { return node_->first; }
+      pointer operator->() const { return &node_->first; }
+      iterator& operator++() {
+        ++node_;
+        return *this;
+      }
+      iterator operator++(int) {
+        auto copy{*this};
+        ++(*this);
+        return copy;
+      }
+
+      friend bool operator==(const iterator& lhs, const iterator& rhs) {
+        return lhs.node_ == rhs.node_;
+      }
+      friend bool operator!=(const iterator& lhs, const iterator& rhs) { return !(lhs == rhs); }
+
+     private:
+      typename std::map<N, std::shared_ptr<Node>>::const_iterator node_;
+      explicit iterator(const decltype(node_)& node) : node_{node} {};
+
+      friend class node_view;
+    };
+
+    iterator begin() const { return iterator(nodes_->cbegin()); }
+    iterator end() const { return iterator(nodes_->cend()); }
+    std::size_t size() const { return nodes_->size(); }
+    bool empty() const { return nodes_->empty(); }
+
+   private:
+    const std::map<N, std::shared_ptr<Node>>* nodes_;
+    explicit node_view(const std::map<N, std::shared_ptr<Node>>& nodes) : nodes_{&nodes} {};
+
+    friend class Graph;
+  };
+
+  // Iterator over a run of one node's edges; Proj::Get turns an Edge into the value yielded
+  // by edge_view or weight_view. Every projection gets the random access operations, but
+  // only weight_view yields real references and so is tagged as random access. edge_view
+  // yields a tuple of references by value, which only meets the input iterator
+  // requirements, and has no operator->.
+  template <typename Proj>
+  class edge_list_iterator {
+   public:
+    using iterator_category = typename Proj::iterator_category;
+    using value_type = typename Proj::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = typename Proj::pointer;
+    using reference = typename Proj::reference;
+
+    edge_list_iterator() = default;
+
+    reference operator*() const { return Proj::Get(**edge_); }
+    template <typename P = pointer, typename = std::enable_if_t<!std::is_void_v<P>>>
+    P operator->() const {
+      return &**this;
+    }
+    reference operator[](difference_type n) const { return *(*this + n); }
+    edge_list_iterator& operator++() {
+      ++edge_;
+      return *this;
+    }
+    edge_list_iterator operator++(int) {
+      auto copy{*this};
+      ++(*this);
+      return copy;
+    }
+    edge_list_iterator& operator--() {
+      --edge_;
+      return *this;
+    }
+    edge_list_iterator operator--(int) {
+      auto copy{*this};
+      --(*this);
+      return copy;
+    }
+    edge_list_iterator& operator+=(difference_type n) {
+      edge_ += n;
+      return *this;
+    }
+    edge_list_iterator& operator-=(difference_type n) {
+      edge_ -= n;
+      return *this;
+    }
+
+    friend edge_list_iterator operator+(edge_list_iterator it, difference_type n) {
+      return it += n;
+    }
+    friend edge_list_iterator operator+(difference_type n, edge_list_iterator it) {
+      return it += n;
+    }
+    friend edge_list_iterator operator-(edge_list_iterator it, difference_type n) {
+      return it -= n;
+    }
+    friend difference_type operator-(const edge_list_iterator& lhs,
+                                     const edge_list_iterator& rhs) {
+      return lhs.edge_ - rhs.edge_;
+    }
+    friend bool operator==(const edge_list_iterator& lhs, const edge_list_iterator& rhs) {
+      return lhs.edge_ == rhs.edge_;
+    }
+    friend bool operator!=(const edge_list_iterator& lhs, const edge_list_iterator& rhs) {
+      return !(lhs == rhs);
+    }
+    friend bool operator<(const edge_list_iterator& lhs, const edge_list_iterator& rhs) {
+      return lhs.edge_ < rhs.edge_;
+    }
+    friend bool operator>(const edge_list_iterator& lhs, const edge_list_iterator& rhs) {
+      return rhs < lhs;
+    }
+    friend bool operator<=(const edge_list_iterator& lhs, const edge_list_iterator& rhs) {
+      return !(rhs < lhs);
+    }
+    friend bool operator>=(const edge_list_iterator& lhs, const edge_list_iterator& rhs) {
+      return !(lhs < rhs);
+    }
+
+   private:
+    typename std::vector<std::shared_ptr<Edge>>::const_iterator edge_;
+    explicit edge_list_iterator(const decltype(edge_)& edge) : edge_{edge} {};
+
+    friend class edge_view;
+    friend class weight_view;
+  };
+
+ private:
+  struct EdgeProj {
+    using iterator_category = std::input_iterator_tag;
+    using value_type = std::tuple<N, N, E>;
+    using pointer = void;
+    using reference = std::tuple<const N&, const N&, const E&>;
+    static reference Get(const Edge& edge) { return {*edge.src_, *edge.dst_, *edge.weight_}; }
+  };
+
+  struct WeightProj {
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = E;
+    using pointer = const E*;
+    using reference = const E&;
+    static reference Get(const Edge& edge) { return *edge.weight_; }
+  };
+
+ public:
+  class edge_view {
+   public:
+    using iterator = edge_list_iterator<EdgeProj>;
+
+    iterator begin() const { return iterator(begin_); }
+    iterator end() const { return iterator(end_); }
+    std::size_t size() const { return static_cast<std::size_t>(end_ - begin_); }
+    bool empty() const { return begin_ == end_; }
+    typename iterator::reference operator[](std::size_t n) const { return begin()[n]; }
+
+   private:
+    typename std::vector<std::shared_ptr<Edge>>::const_iterator begin_;
+    typename std::vector<std::shared_ptr<Edge>>::const_iterator end_;
+    edge_view(const decltype(begin_)& begin, const decltype(end_)& end)
+      : begin_{begin}, end_{end} {};
+
+    friend class Graph;
+  };
+
+  class weight_view {
+   public:
+    using iterator = edge_list_iterator<WeightProj>;
+
+    iterator begin() const { return iterator(begin_); }
+    iterator end() const { return iterator(end_); }
+    std::size_t size() const { return static_cast<std::size_t>(end_ - begin_); }
+    bool empty() const { return begin_ == end_; }
+    typename iterator::reference operator[](std::size_t n) const { return begin()[n]; }
+
+   private:
+    typename std::vector<std::shared_ptr<Edge>>::const_iterator begin_;
+    typename std::vector<std::shared_ptr<Edge>>::const_iterator end_;
+    weight_view(const decltype(begin_)& begin, const decltype(end_)& end)
+      : begin_{begin}, end_{end} {};
+
+    friend class Graph;
+  };
+
+  class dfs_range {
+   public:
+    class iterator {
+     public:
+      using iterator_category = std::input_iterator_tag;
+      using value_type = N;
+      using difference_type = std::ptrdiff_t;
+      using pointer = const N*;
+      using reference = const N&;
+
+      reference operator*() const { return *range_->current_->val_; }
+      pointer operator->() const { return range_->current_->val_.get(); }
+      iterator& operator++() {
+        range_->Advance();
+        return *this;
+      }
+      void operator++(int) { ++(*this); }
+
+      friend bool operator==(const iterator& lhs, const iterator& rhs) {
+        return lhs.Done() == rhs.Done();
+      }
+      friend bool operator!=(const iterator& lhs, const iterator& rhs) { return !(lhs == rhs); }
+
+     private:
+      dfs_range* range_;
+      explicit iterator(dfs_range* range) : range_{range} {};
+      bool Done() const { return range_ == nullptr || range_->current_ == nullptr; }
+
+      friend class dfs_range;
+    };
+
+    dfs_range(const dfs_range&) = delete;
+    dfs_range(dfs_range&&) noexcept = default;
+    dfs_range& operator=(const dfs_range&) = delete;
+    dfs_range& operator=(dfs_range&&) noexcept = default;
+
+    iterator begin() { return iterator(this); }
+    iterator end() { return iterator(nullptr); }
+
+   private:
+    std::function<bool(const N&)> prune_;
+    std::vector<std::pair<const Node*, std::size_t>> stack_;
+    std::unordered_set<const Node*> visited_;
+    const Node* current_ = nullptr;
+
+    dfs_range(const Node* start, std::function<bool(const N&)> prune)
+      : prune_{std::move(prune)} {
+      Visit(start);
+    }
+
+    void Visit(const Node* node) {
+      visited_.insert(node);
+      current_ = node;
+      bool pruned = prune_ && prune_(*node->val_);
+      stack_.emplace_back(node, pruned ? node->outGoing_.size() : 0);
+    }
+
+    void Advance() {
+      while (!stack_.empty()) {
+        auto& [node, next] = stack_.back();
+        if (next == node->outGoing_.size()) {
+          stack_.pop_back();
+          continue;
+        }
+        const Node* child = node->outGoing_[next++]->dstNode_;
+        if (visited_.count(child) == 0) {
+          Visit(child);
+          return;
+        }
+      }
+      current_ = nullptr;
+    }
+
+    friend class Graph;
+  };
+
+  class bfs_range {
+   public:
+    class iterator {
+     public:
+      using iterator_category = std::input_iterator_tag;
+      using value_type = N;
+      using difference_type = std::ptrdiff_t;
+      using pointer = const N*;
+      using reference = const N&;
+
+      reference operator*() const { return *range_->queue_.front()->val_; }
+      pointer operator->() const { return range_->queue_.front()->val_.get(); }
+      iterator& operator++() {
+        range_->Advance();
+        return *this;
+      }
+      void operator++(int) { ++(*this); }
+
+      friend bool operator==(const iterator& lhs, const iterator& rhs) {
+        return lhs.Done() == rhs.Done();
+      }
+      friend bool operator!=(const iterator& lhs, const iterator& rhs) { return !(lhs == rhs); }
+
+     private:
+      bfs_range* range_;
+      explicit iterator(bfs_range* range) : range_{range} {};
+      bool Done() const { return range_ == nullptr || range_->queue_.empty(); }
+
+      friend class bfs_range;
+    };
+
+    bfs_range(const bfs_range&) = delete;
+    bfs_range(bfs_range&&) noexcept = default;
+    bfs_range& operator=(const bfs_range&) = delete;
+    bfs_range& operator=(bfs_range&&) noexcept = default;
+
+    iterator begin() { return iterator(this); }
+    iterator end() { return iterator(nullptr); }
+
+   private:
+    std::function<bool(const N&)> prune_;
+    std::deque<const Node*> queue_;
+    std::unordered_set<const Node*> visited_;
+
+    bfs_range(const Node* start, std::function<bool(const N&)> prune)
+      : prune_{std::move(prune)} {
+      visited_.insert(start);
+      queue_.push_back(start);
+    }
+
+    void Advance() {
+      const Node* node = queue_.front();
+      queue_.pop_front();
+      if (prune_ && prune_(*node->val_)) {
+        return;
+      }
+      for (const auto& edge : node->outGoing_) {
+        const Node* child = edge->dstNode_;
+        if (visited_.insert(child).second) {
+          queue_.push_back(child);
+        }
+      }
+    }
+
+    friend class Graph;
+  };
+
+  class path_range {
+   public:
+    using path = std::vector<std::reference_wrapper<const N>>;
+
+    class iterator {
+     public:
+      using iterator_category = std::input_iterator_tag;
+      using value_type = path;
+      using difference_type = std::ptrdiff_t;
+      using pointer = const path*;
+      using reference = const path&;
+
+      reference operator*() const { return range_->path_; }
+      pointer operator->() const { return &range_->path_; }
+      iterator& operator++() {
+        range_->Advance();
+        return *this;
+      }
+      void operator++(int) { ++(*this); }
+
+      friend bool operator==(const iterator& lhs, const iterator& rhs) {
+        return lhs.Done() == rhs.Done();
+      }
+      friend bool operator!=(const iterator& lhs, const iterator& rhs) { return !(lhs == rhs); }
+
+     private:
+      path_range* range_;
+      explicit iterator(path_range* range) : range_{range} {};
+      bool Done() const { return range_ == nullptr || range_->stack_.empty(); }
+
+      friend class path_range;
+    };
+
+    path_range(const path_range&) = delete;
+    path_range(path_range&&) noexcept = default;
+    path_range& operator=(const path_range&) = delete;
+    path_range& operator=(path_range&&) noexcept = default;
+
+    iterator begin() { return iterator(this); }
+    iterator end() { return iterator(nullptr); }
+
+   private:
+    const Node* dst_;
+    std::size_t maxLen_;
+    std::function<bool(const N&)> prune_;
+    // Between steps the top of the stack is always dst_, unless the range is exhausted.
+    std::vector<std::pair<const Node*, std::size_t>> stack_;
+    std::unordered_set<const Node*> onPath_;
+    path path_;
+
+    path_range(const Node* src,
+               const Node* dst,
+               std::size_t maxLen,
+               std::function<bool(const N&)> prune)
+      : dst_{dst}, maxLen_{maxLen}, prune_{std::move(prune)} {
+      Push(src);
+      if (src != dst_) {
+        Advance();
+      }
+    }
+
+    void Push(const Node* node) {
+      bool stop = node == dst_ || path_.size() == maxLen_ || (prune_ && prune_(*node->val_));
+      onPath_.insert(node);
+      path_.push_back(std::cref(*node->val_));
+      stack_.emplace_back(node, stop ? node->outGoing_.size() : 0);
+    }
+
+    void Advance() {
+      while (!stack_.empty()) {
+        auto& [node, next] = stack_.back();
+        const auto& edges = node->outGoing_;
+        if (next == edges.size()) {
+          onPath_.erase(node);
+          path_.pop_back();
+          stack_.pop_back();
+          continue;
+        }
+        // Parallel edges lead to the same path, so step over them together.
+        auto first = next;
+        do {
+          ++next;
+        } while (next < edges.size() && edges[next]->dst_ == edges[first]->dst_);
+        const Node* child = edges[first]->dstNode_;
+        if (onPath_.count(child) == 0) {
+          Push(child);
+          if (child == dst_) {
+            return;
+          }
+        }
+      }
+    }
+
+    friend class Graph;
+  };
 };
 
+namespace detail {
+
+// Base of std::hash<Graph<N, E>>. When N or E has no std::hash the hash is disabled like
+// std::hash of an unhashable type, so kIsHashable<Graph<N, E>> is false rather than an error.
+template <typename N, typename E, bool Enabled = kIsHashable<N> && kIsHashable<E>>
+struct GraphHash {
+  std::size_t operator()(const Graph<N, E>& g) const noexcept { return g.Fingerprint(); }
+};
+
+template <typename N, typename E>
+struct GraphHash<N, E, false> {
+  GraphHash() = delete;
+  GraphHash(const GraphHash&) = delete;
+  GraphHash& operator=(const GraphHash&) = delete;
+};
+
+}  // namespace detail
+
 }  // namespace gdwg
 
+namespace std {
+
+template <typename N, typename E>
+struct hash<gdwg::Graph<N, E>> : gdwg::detail::GraphHash<N, E> {};
+
+}  // namespace std
+
 #include "assignments/dg/graph.tpp"
 
 #endif  // ASSIGNMENTS_DG_GRAPH_H_
@@ -1,8 +1,65 @@
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
 #include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
 #include <tuple>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
+namespace gdwg::detail {
+
+inline unsigned ThreadCount(const parallel_policy& policy) {
+  if (policy.threads != 0) {
+    return policy.threads;
+  }
+  return std::max(1U, std::thread::hardware_concurrency());
+}
+
+// Calls chunkFn(i) for every i in [0, numChunks) on up to ThreadCount(policy) threads,
+// including the calling one. Threads claim the next free chunk as they finish.
+template <typename F>
+void RunChunks(const parallel_policy& policy, std::size_t numChunks, F chunkFn) {
+  std::atomic<std::size_t> next{0};
+  std::exception_ptr error;
+  std::mutex errorMutex;
+  auto worker = [&]() {
+    for (auto chunk = next++; chunk < numChunks; chunk = next++) {
+      try {
+        chunkFn(chunk);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock{errorMutex};
+        if (!error) {
+          error = std::current_exception();
+        }
+        next = numChunks;
+      }
+    }
+  };
+  auto threads = std::min<std::size_t>(ThreadCount(policy), numChunks);
+  std::vector<std::thread> pool;
+  for (std::size_t i = 1; i < threads; ++i) {
+    pool.emplace_back(worker);
+  }
+  worker();
+  for (auto& thread : pool) {
+    thread.join();
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+}  // namespace gdwg::detail
+
 // ---------------------- Constructors ----------------------
 template <typename N, typename E>
 gdwg::Graph<N, E>::Graph() = default;
@@ -38,11 +95,15 @@ gdwg::Graph<N, E>::Graph(std::initializer_list<N> list) {
 
 template <typename N, typename E>
 gdwg::Graph<N, E>::Graph(const gdwg::Graph<N, E>& toCopy) noexcept {
-  nodes_ = toCopy.nodes_;
+  CopyFrom(toCopy);
 }
 
 template <typename N, typename E>
-gdwg::Graph<N, E>::Graph(gdwg::Graph<N, E>&& toMove) noexcept : nodes_{std::move(toMove.nodes_)} {}
+gdwg::Graph<N, E>::Graph(gdwg::Graph<N, E>&& toMove) noexcept
+  : nodes_{std::move(toMove.nodes_)}, fingerprint_{toMove.fingerprint_} {
+  toMove.nodes_.clear();
+  toMove.fingerprint_ = 0;
+}
 
 template <typename N, typename E>
 gdwg::Graph<N, E>::~Graph() = default;
@@ -51,16 +112,42 @@ gdwg::Graph<N, E>::~Graph() = default;
 
 template <typename N, typename E>
 gdwg::Graph<N, E>& gdwg::Graph<N, E>::operator=(const Graph<N, E>& toCopy) {
-  nodes_ = toCopy.nodes_;
+  if (this != &toCopy) {
+    Clear();
+    CopyFrom(toCopy);
+  }
   return *this;
 }
 
 template <typename N, typename E>
 gdwg::Graph<N, E>& gdwg::Graph<N, E>::operator=(Graph<N, E>&& toMove) noexcept {
   nodes_ = std::move(toMove.nodes_);
+  fingerprint_ = toMove.fingerprint_;
+  toMove.nodes_.clear();
+  toMove.fingerprint_ = 0;
   return *this;
 }
 
+// Copies node values and edges rather than the shared Node objects, so the copy can be
+// mutated independently. Both edge lists come out already sorted.
+template <typename N, typename E>
+void gdwg::Graph<N, E>::CopyFrom(const Graph<N, E>& other) {
+  for (const auto& [val, node] : other.nodes_) {
+    InsertNode(val);
+  }
+  for (const auto& [val, node] : other.nodes_) {
+    auto& srcNode = nodes_.at(val);
+    for (const auto& edge : node->outGoing_) {
+      auto& dstNode = nodes_.at(*edge->dst_);
+      auto newEdge = std::make_shared<Edge>(srcNode->val_, dstNode->val_,
+                                            std::make_shared<E>(*edge->weight_), dstNode.get());
+      srcNode->outGoing_.push_back(newEdge);
+      dstNode->inGoing_.push_back(newEdge);
+    }
+  }
+  fingerprint_ = other.fingerprint_;
+}
+
 // ---------------------- Methods ----------------------
 template <typename N, typename E>
 bool gdwg::Graph<N, E>::InsertNode(const N& val) {
@@ -70,6 +157,7 @@ bool gdwg::Graph<N, E>::InsertNode(const N& val) {
   auto valCpy = std::make_shared<N>(val);
   auto newN = Node(valCpy);
   nodes_.insert(std::make_pair(*valCpy, std::make_shared<Node>(newN)));
+  fingerprint_ += NodeHash(val);
   return true;
 }
 
@@ -84,7 +172,7 @@ bool gdwg::Graph<N, E>::InsertEdge(const N& src, const N& dst, const E& w) {
   auto srcNode = nodes_.at(src);
   auto dstNode = nodes_.at(dst);
   auto wCpy = std::make_shared<E>(w);
-  Edge ed = Edge{srcNode->val_, dstNode->val_, wCpy};
+  Edge ed = Edge{srcNode->val_, dstNode->val_, wCpy, dstNode.get()};
   auto newEdge = std::make_shared<Edge>(ed);
   bool foundPos = false;
   for (auto it = srcNode->outGoing_.begin(); it != srcNode->outGoing_.end(); ++it) {
@@ -108,6 +196,7 @@ bool gdwg::Graph<N, E>::InsertEdge(const N& src, const N& dst, const E& w) {
   if (!foundPos) {
     dstNode->inGoing_.push_back(newEdge);
   }
+  fingerprint_ += EdgeHash(src, dst, w);
   return true;
 }
 
@@ -117,7 +206,9 @@ bool gdwg::Graph<N, E>::DeleteNode(const N& del) {
     return false;
   }
   auto& nodeRmv = nodes_.at(del);
+  fingerprint_ -= NodeHash(del);
   for (auto edge : nodeRmv->inGoing_) {
+    fingerprint_ -= EdgeHash(*edge->src_, *edge->dst_, *edge->weight_);
     std::shared_ptr<N>& src = edge->src_;
     std::vector<std::shared_ptr<Edge>>& srcEdges = nodes_.at(*src)->outGoing_;
     for (auto iter = srcEdges.begin(); iter != srcEdges.end(); ++iter) {
@@ -127,6 +218,18 @@ bool gdwg::Graph<N, E>::DeleteNode(const N& del) {
       }
     }
   }
+  // Self edges were already removed from outGoing_ above.
+  for (auto edge : nodeRmv->outGoing_) {
+    fingerprint_ -= EdgeHash(*edge->src_, *edge->dst_, *edge->weight_);
+    std::shared_ptr<N>& dst = edge->dst_;
+    std::vector<std::shared_ptr<Edge>>& dstEdges = nodes_.at(*dst)->inGoing_;
+    for (auto iter = dstEdges.begin(); iter != dstEdges.end(); ++iter) {
+      if (*iter == edge) {
+        dstEdges.erase(iter);
+        break;
+      }
+    }
+  }
   nodes_.erase(del);
   return true;
 }
@@ -204,10 +307,11 @@ void gdwg::Graph<N, E>::MergeReplace(const N& oldData, const N& newData) {
 template <typename N, typename E>
 void gdwg::Graph<N, E>::Clear() {
   nodes_.clear();
+  fingerprint_ = 0;
 }
 
 template <typename N, typename E>
-bool gdwg::Graph<N, E>::IsNode(const N& val) {
+bool gdwg::Graph<N, E>::IsNode(const N& val) const {
   return nodes_.count(val);
 }
 
@@ -217,31 +321,19 @@ bool gdwg::Graph<N, E>::IsConnected(const N& src, const N& dst) {
     throw std::runtime_error("Cannot call Graph::IsConnected if src or dst "
                              "node don't exist in the graph");
   }
-  auto& nSrc = nodes_.at(src);
-  auto& nDst = nodes_.at(dst);
-  for (auto& edge : nSrc->outGoing_) {
-    if (edge->src_ == nSrc->val_ && edge->dst_ == nDst->val_)
-      return true;
-  }
-  return false;
+  return !Weights(src, dst).empty();
 }
 
 template <typename N, typename E>
 bool gdwg::Graph<N, E>::IsConnectedWeight(const N& src, const N& dst, const E& weight) {
-  for (auto i : GetWeights(src, dst)) {
-    if (i == weight)
-      return true;
-  }
-  return false;
+  auto weights = Weights(src, dst);
+  return std::binary_search(weights.begin(), weights.end(), weight);
 }
 
 template <typename N, typename E>
 std::vector<N> gdwg::Graph<N, E>::GetNodes() const {
-  std::vector<N> vec;
-  for (auto it = nodes_.begin(); it != nodes_.end(); ++it) {
-    vec.push_back(it->first);
-  }
-  return vec;
+  auto view = Nodes();
+  return std::vector<N>(view.begin(), view.end());
 }
 
 template <typename N, typename E>
@@ -249,13 +341,10 @@ std::vector<N> gdwg::Graph<N, E>::GetConnected(const N& src) {
   if (!IsNode(src)) {
     throw std::out_of_range("Cannot call Graph::GetConnected if src doesn't exist in the graph");
   }
-  auto& nSrc = nodes_.at(src);
-  std::vector<N> vec(nSrc->outGoing_.size());
-  int i = 0;
-  for (auto& edge : nSrc->outGoing_) {
-    auto& dsts = *(edge->dst_);
-    vec[i] = dsts;
-    i++;
+  std::vector<N> vec;
+  vec.reserve(nodes_.at(src)->outGoing_.size());
+  for (const auto& [from, to, weight] : OutEdges(src)) {
+    vec.push_back(to);
   }
   return vec;
 }
@@ -266,16 +355,482 @@ std::vector<E> gdwg::Graph<N, E>::GetWeights(const N& src, const N& dst) {
     throw std::out_of_range("Cannot call Graph::GetWeights if src or dst node "
                             "don't exist in the graph");
   }
-  std::vector<E> vec;
-  auto& nSrc = nodes_.at(src);
-  auto& nDst = nodes_.at(dst);
-  for (auto& edge : nSrc->outGoing_) {
-    if (edge->src_ == nSrc->val_ && edge->dst_ == nDst->val_) {
-      vec.push_back(*edge->weight_);
+  auto view = Weights(src, dst);
+  return std::vector<E>(view.begin(), view.end());
+}
+
+template <typename N, typename E>
+typename gdwg::Graph<N, E>::node_view gdwg::Graph<N, E>::Nodes() const {
+  return node_view(nodes_);
+}
+
+template <typename N, typename E>
+typename gdwg::Graph<N, E>::edge_view gdwg::Graph<N, E>::OutEdges(const N& src) const {
+  auto it = nodes_.find(src);
+  if (it == nodes_.end()) {
+    throw std::out_of_range("Cannot call Graph::OutEdges if src doesn't exist in the graph");
+  }
+  const auto& edges = it->second->outGoing_;
+  return edge_view(edges.cbegin(), edges.cend());
+}
+
+template <typename N, typename E>
+typename gdwg::Graph<N, E>::edge_view gdwg::Graph<N, E>::InEdges(const N& dst) const {
+  auto it = nodes_.find(dst);
+  if (it == nodes_.end()) {
+    throw std::out_of_range("Cannot call Graph::InEdges if dst doesn't exist in the graph");
+  }
+  const auto& edges = it->second->inGoing_;
+  return edge_view(edges.cbegin(), edges.cend());
+}
+
+template <typename N, typename E>
+typename gdwg::Graph<N, E>::weight_view gdwg::Graph<N, E>::Weights(const N& src,
+                                                                    const N& dst) const {
+  auto srcIt = nodes_.find(src);
+  if (srcIt == nodes_.end() || nodes_.find(dst) == nodes_.end()) {
+    throw std::out_of_range("Cannot call Graph::Weights if src or dst node "
+                            "don't exist in the graph");
+  }
+  // outGoing_ is sorted by (dst, weight), so the edges to dst form one contiguous run.
+  const auto& edges = srcIt->second->outGoing_;
+  auto first = std::lower_bound(
+      edges.cbegin(), edges.cend(), dst,
+      [](const std::shared_ptr<Edge>& edge, const N& val) { return *edge->dst_ < val; });
+  auto last = std::upper_bound(
+      first, edges.cend(), dst,
+      [](const N& val, const std::shared_ptr<Edge>& edge) { return val < *edge->dst_; });
+  return weight_view(first, last);
+}
+
+template <typename N, typename E>
+typename gdwg::Graph<N, E>::dfs_range
+gdwg::Graph<N, E>::Dfs(const N& start, std::function<bool(const N&)> prune) const {
+  auto it = nodes_.find(start);
+  if (it == nodes_.end()) {
+    throw std::out_of_range("Cannot call Graph::Dfs if start doesn't exist in the graph");
+  }
+  return dfs_range(it->second.get(), std::move(prune));
+}
+
+template <typename N, typename E>
+typename gdwg::Graph<N, E>::bfs_range
+gdwg::Graph<N, E>::Bfs(const N& start, std::function<bool(const N&)> prune) const {
+  auto it = nodes_.find(start);
+  if (it == nodes_.end()) {
+    throw std::out_of_range("Cannot call Graph::Bfs if start doesn't exist in the graph");
+  }
+  return bfs_range(it->second.get(), std::move(prune));
+}
+
+template <typename N, typename E>
+typename gdwg::Graph<N, E>::path_range
+gdwg::Graph<N, E>::Paths(const N& src,
+                         const N& dst,
+                         std::size_t maxLen,
+                         std::function<bool(const N&)> prune) const {
+  auto srcIt = nodes_.find(src);
+  auto dstIt = nodes_.find(dst);
+  if (srcIt == nodes_.end() || dstIt == nodes_.end()) {
+    throw std::out_of_range("Cannot call Graph::Paths if src or dst node "
+                            "don't exist in the graph");
+  }
+  return path_range(srcIt->second.get(), dstIt->second.get(), maxLen, std::move(prune));
+}
+
+template <typename N, typename E>
+template <typename F>
+void gdwg::Graph<N, E>::ForEachEdge(sequenced_policy, F fn) const {
+  for (const auto& [val, node] : nodes_) {
+    for (const auto& edge : node->outGoing_) {
+      fn(*edge->src_, *edge->dst_, *edge->weight_);
     }
   }
-  return vec;
 }
+
+template <typename N, typename E>
+template <typename F>
+void gdwg::Graph<N, E>::ForEachEdge(const parallel_policy& policy, F fn) const {
+  std::size_t numEdges = 0;
+  for (const auto& [val, node] : nodes_) {
+    numEdges += node->outGoing_.size();
+  }
+  if (numEdges == 0) {
+    return;
+  }
+  auto grain = policy.grain;
+  if (grain == 0) {
+    grain = std::max<std::size_t>(1, numEdges / (8 * detail::ThreadCount(policy)));
+  }
+  // A chunk covers grain edges starting at an offset into one node's outgoing edges.
+  std::vector<std::pair<typename std::map<N, std::shared_ptr<Node>>::const_iterator, std::size_t>>
+      starts;
+  starts.reserve(numEdges / grain + 1);
+  std::size_t filled = grain;
+  for (auto it = nodes_.cbegin(); it != nodes_.cend(); ++it) {
+    auto degree = it->second->outGoing_.size();
+    for (std::size_t offset = 0; offset < degree;) {
+      if (filled == grain) {
+        starts.emplace_back(it, offset);
+        filled = 0;
+      }
+      auto take = std::min(grain - filled, degree - offset);
+      filled += take;
+      offset += take;
+    }
+  }
+  detail::RunChunks(policy, starts.size(), [this, &starts, grain, &fn](std::size_t chunk) {
+    auto [it, offset] = starts[chunk];
+    for (std::size_t left = grain; left > 0 && it != nodes_.cend(); ++it, offset = 0) {
+      const auto& edges = it->second->outGoing_;
+      for (; offset < edges.size() && left > 0; ++offset, --left) {
+        const auto& edge = edges[offset];
+        fn(*edge->src_, *edge->dst_, *edge->weight_);
+      }
+    }
+  });
+}
+
+template <typename N, typename E>
+template <typename F>
+void gdwg::Graph<N, E>::ForEachNode(sequenced_policy, F fn) const {
+  for (const auto& [val, node] : nodes_) {
+    fn(val);
+  }
+}
+
+template <typename N, typename E>
+template <typename F>
+void gdwg::Graph<N, E>::ForEachNode(const parallel_policy& policy, F fn) const {
+  if (nodes_.empty()) {
+    return;
+  }
+  auto grain = policy.grain;
+  if (grain == 0) {
+    grain = std::max<std::size_t>(1, nodes_.size() / (8 * detail::ThreadCount(policy)));
+  }
+  std::vector<typename std::map<N, std::shared_ptr<Node>>::const_iterator> starts;
+  starts.reserve(nodes_.size() / grain + 1);
+  std::size_t i = 0;
+  for (auto it = nodes_.cbegin(); it != nodes_.cend(); ++it, ++i) {
+    if (i % grain == 0) {
+      starts.push_back(it);
+    }
+  }
+  detail::RunChunks(policy, starts.size(), [this, &starts, grain, &fn](std::size_t chunk) {
+    auto it = starts[chunk];
+    for (std::size_t left = grain; left > 0 && it != nodes_.cend(); ++it, --left) {
+      fn(it->first);
+    }
+  });
+}
+
+namespace gdwg::detail {
+
+constexpr std::size_t kExportBlock = 1 << 20;
+// Upper bound on the nodes plus edges in one parallel export chunk, which keeps the ring of
+// chunk buffers small however large the graph is.
+constexpr std::size_t kExportGrain = 1 << 14;
+
+template <typename T>
+constexpr bool kIsCharType = std::is_same_v<T, char> || std::is_same_v<T, signed char> ||
+                             std::is_same_v<T, unsigned char>;
+
+// Text of val for the edge list and DOT formats. Strings are copied and other class types
+// go through os << val. Numbers go through std::to_chars instead: integers come out as
+// they would from os << val, but floating point values are written in the shortest form
+// that reads back exactly, so 0.1 + 0.2 is "0.30000000000000004" and 1234567.0 is
+// "1234567" where os << val would give "0.3" and "1.23457e+06".
+template <typename T>
+void AppendText(std::string& buf, const T& val) {
+  if constexpr (std::is_same_v<T, bool>) {
+    buf.push_back(val ? '1' : '0');
+  } else if constexpr (kIsCharType<T>) {
+    buf.push_back(static_cast<char>(val));
+  } else if constexpr (std::is_arithmetic_v<T>) {
+    char tmp[64];
+    auto result = std::to_chars(tmp, tmp + sizeof(tmp), val);
+    buf.append(tmp, result.ptr);
+  } else if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+    buf.append(std::string_view(val));
+  } else {
+    std::ostringstream os;
+    os << val;
+    buf.append(os.str());
+  }
+}
+
+// Appends val as a double-quoted DOT identifier.
+template <typename T>
+void AppendQuoted(std::string& buf, const T& val) {
+  auto start = buf.size();
+  buf.push_back('"');
+  AppendText(buf, val);
+  for (auto i = start + 1; i < buf.size(); ++i) {
+    if (buf[i] == '"' || buf[i] == '\\') {
+      buf.insert(i++, 1, '\\');
+    }
+  }
+  buf.push_back('"');
+}
+
+template <typename T>
+void AppendRaw(std::string& buf, const T& val) {
+  buf.append(reinterpret_cast<const char*>(&val), sizeof(val));
+}
+
+template <typename T>
+void AppendBinary(std::string& buf, const T& val) {
+  if constexpr (std::is_trivially_copyable_v<T>) {
+    AppendRaw(buf, val);
+  } else {
+    auto lenPos = buf.size();
+    AppendRaw(buf, std::uint32_t{0});
+    AppendText(buf, val);
+    auto len = static_cast<std::uint32_t>(buf.size() - lenPos - sizeof(std::uint32_t));
+    std::copy_n(reinterpret_cast<const char*>(&len), sizeof(len), buf.begin() + lenPos);
+  }
+}
+
+// Calls format(i, buf) for every i in [0, numChunks) on `threads` worker threads while the
+// calling thread passes the filled buffers to write(buf) in chunk order. Chunks share a
+// ring of 2 * threads buffers, so a worker only moves on to chunk i once chunk
+// i - ring.size() has been written. The first exception from either side stops both and
+// is rethrown once the workers have finished.
+template <typename Format, typename Write>
+void RunOrdered(unsigned threads, std::size_t numChunks, Format format, Write write) {
+  std::vector<std::string> ring(std::min<std::size_t>(numChunks, 2 * threads));
+  std::vector<bool> full(ring.size());
+  std::size_t written = 0;
+  bool stop = false;
+  std::exception_ptr error;
+  std::mutex mutex;
+  std::condition_variable chunkFull;
+  std::condition_variable slotFree;
+  auto fail = [&](std::exception_ptr e) {
+    std::lock_guard<std::mutex> lock{mutex};
+    if (!error) {
+      error = e;
+    }
+    stop = true;
+    chunkFull.notify_all();
+    slotFree.notify_all();
+  };
+
+  std::atomic<std::size_t> next{0};
+  auto worker = [&]() {
+    for (auto chunk = next++; chunk < numChunks; chunk = next++) {
+      auto slot = chunk % ring.size();
+      {
+        std::unique_lock<std::mutex> lock{mutex};
+        slotFree.wait(lock, [&]() { return stop || chunk < written + ring.size(); });
+        if (stop) {
+          return;
+        }
+      }
+      try {
+        ring[slot].clear();
+        format(chunk, ring[slot]);
+      } catch (...) {
+        fail(std::current_exception());
+        return;
+      }
+      std::lock_guard<std::mutex> lock{mutex};
+      full[slot] = true;
+      chunkFull.notify_one();
+    }
+  };
+  std::vector<std::thread> pool;
+  for (std::size_t i = 0; i < std::min<std::size_t>(threads, numChunks); ++i) {
+    pool.emplace_back(worker);
+  }
+
+  try {
+    for (std::size_t chunk = 0; chunk < numChunks; ++chunk) {
+      auto slot = chunk % ring.size();
+      {
+        std::unique_lock<std::mutex> lock{mutex};
+        chunkFull.wait(lock, [&]() { return stop || full[slot]; });
+        if (stop) {
+          break;
+        }
+      }
+      write(ring[slot]);
+      std::lock_guard<std::mutex> lock{mutex};
+      full[slot] = false;
+      ++written;
+      slotFree.notify_all();
+    }
+  } catch (...) {
+    fail(std::current_exception());
+  }
+  for (auto& thread : pool) {
+    thread.join();
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+}  // namespace gdwg::detail
+
+template <typename N, typename E>
+void gdwg::Graph<N, E>::Export(std::ostream& os, const export_options& options) const {
+  if (options.format == export_format::kDot) {
+    os.write("digraph {\n", 10);
+  } else if (options.format == export_format::kBinary) {
+    os.write("GDWG\x01", 5);
+  }
+  auto threads = detail::ThreadCount(options.policy);
+  if (threads <= 1) {
+    std::string buf;
+    for (const auto& [val, node] : nodes_) {
+      ExportNode(buf, *node, options);
+      if (buf.size() >= detail::kExportBlock) {
+        os.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+        buf.clear();
+      }
+    }
+    os.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+  } else {
+    // Chunks hold about the same number of nodes plus edges. Workers format them while
+    // this thread writes the finished ones in order.
+    std::size_t total = nodes_.size();
+    for (const auto& [val, node] : nodes_) {
+      total += node->outGoing_.size();
+    }
+    auto grain = options.policy.grain;
+    if (grain == 0) {
+      grain = std::clamp<std::size_t>(total / (8 * threads), 1, detail::kExportGrain);
+    }
+    std::vector<typename std::map<N, std::shared_ptr<Node>>::const_iterator> starts;
+    std::size_t filled = grain;
+    for (auto it = nodes_.cbegin(); it != nodes_.cend(); ++it) {
+      if (filled >= grain) {
+        starts.push_back(it);
+        filled = 0;
+      }
+      filled += 1 + it->second->outGoing_.size();
+    }
+    starts.push_back(nodes_.cend());
+    detail::RunOrdered(
+        threads, starts.size() - 1,
+        [&](std::size_t chunk, std::string& buf) {
+          for (auto it = starts[chunk]; it != starts[chunk + 1]; ++it) {
+            ExportNode(buf, *it->second, options);
+          }
+        },
+        [&](const std::string& buf) {
+          os.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+        });
+  }
+  if (options.format == export_format::kDot) {
+    os.write("}\n", 2);
+  }
+}
+
+template <typename N, typename E>
+void gdwg::Graph<N, E>::ExportNode(std::string& buf,
+                                   const Node& node,
+                                   const export_options& options) const {
+  if (options.filter && !options.filter(*node.val_)) {
+    return;
+  }
+  const auto& filter = options.dstFilter ? options.dstFilter : options.filter;
+  switch (options.format) {
+    case export_format::kEdgeList: {
+      // Every line from this node starts with the same "src ", so it is formatted once.
+      std::string src;
+      for (const auto& edge : node.outGoing_) {
+        if (!filter || filter(*edge->dst_)) {
+          if (src.empty()) {
+            detail::AppendText(src, *node.val_);
+            src.push_back(' ');
+          }
+          buf.append(src);
+          detail::AppendText(buf, *edge->dst_);
+          buf.push_back(' ');
+          detail::AppendText(buf, *edge->weight_);
+          buf.push_back('\n');
+        }
+      }
+      break;
+    }
+    case export_format::kDot:
+      buf.append("  ");
+      detail::AppendQuoted(buf, *node.val_);
+      buf.append(";\n");
+      for (const auto& edge : node.outGoing_) {
+        if (!filter || filter(*edge->dst_)) {
+          buf.append("  ");
+          detail::AppendQuoted(buf, *edge->src_);
+          buf.append(" -> ");
+          detail::AppendQuoted(buf, *edge->dst_);
+          buf.append(" [label=");
+          detail::AppendQuoted(buf, *edge->weight_);
+          buf.append("];\n");
+        }
+      }
+      break;
+    case export_format::kBinary: {
+      detail::AppendBinary(buf, *node.val_);
+      auto degreePos = buf.size();
+      std::uint32_t degree = 0;
+      detail::AppendRaw(buf, degree);
+      for (const auto& edge : node.outGoing_) {
+        if (!filter || filter(*edge->dst_)) {
+          detail::AppendBinary(buf, *edge->dst_);
+          detail::AppendBinary(buf, *edge->weight_);
+          degree++;
+        }
+      }
+      std::copy_n(reinterpret_cast<const char*>(&degree), sizeof(degree),
+                  buf.begin() + degreePos);
+      break;
+    }
+  }
+}
+
+template <typename N, typename E>
+std::size_t gdwg::Graph<N, E>::Fingerprint() const noexcept {
+  return fingerprint_;
+}
+
+// Node and edge hashes are summed into fingerprint_, so each one is passed through a
+// splitmix64 finaliser first. Values without std::hash hash as 0 but still count towards
+// the total.
+namespace gdwg::detail {
+
+inline std::size_t Mix(std::uint64_t h) {
+  h += 0x9e3779b97f4a7c15ULL;
+  h = (h ^ (h >> 30U)) * 0xbf58476d1ce4e5b9ULL;
+  h = (h ^ (h >> 27U)) * 0x94d049bb133111ebULL;
+  return static_cast<std::size_t>(h ^ (h >> 31U));
+}
+
+template <typename T>
+std::size_t HashOf(const T& val) {
+  if constexpr (kIsHashable<T>) {
+    return std::hash<T>{}(val);
+  } else {
+    return 0;
+  }
+}
+
+}  // namespace gdwg::detail
+
+template <typename N, typename E>
+std::size_t gdwg::Graph<N, E>::NodeHash(const N& val) {
+  return detail::Mix(detail::HashOf(val));
+}
+
+template <typename N, typename E>
+std::size_t gdwg::Graph<N, E>::EdgeHash(const N& src, const N& dst, const E& w) {
+  auto h = detail::Mix(detail::HashOf(src) ^ 0x5bd1e995U);
+  h = detail::Mix(h ^ detail::HashOf(dst));
+  return detail::Mix(h ^ detail::HashOf(w));
+}
+
 template <typename N, typename E>
 typename gdwg::Graph<N, E>::const_iterator
 gdwg::Graph<N, E>::find(const N& src, const N& dst, const E& weight) {
@@ -307,7 +862,8 @@ bool gdwg::Graph<N, E>::erase(const N& src, const N& dst, const E& w) {
 template <typename N, typename E>
 typename gdwg::Graph<N, E>::const_iterator gdwg::Graph<N, E>::erase(const_iterator it) {
   auto rm = it++;
-  auto& edge = *rm.edge_;
+  auto edge = *rm.edge_;
+  fingerprint_ -= EdgeHash(*edge->src_, *edge->dst_, *edge->weight_);
   auto& src = *rm.node_->second;
   for (auto iter = src.outGoing_.begin(); iter != src.outGoing_.end(); ++iter) {
     if (*iter == edge) {
@@ -316,9 +872,9 @@ typename gdwg::Graph<N, E>::const_iterator gdwg::Graph<N, E>::erase(const_iterat
     }
   }
   auto& dst = nodes_.at(*edge->dst_);
-  for (auto iter = dst->outGoing_.begin(); iter != dst->outGoing_.end(); ++iter) {
+  for (auto iter = dst->inGoing_.begin(); iter != dst->inGoing_.end(); ++iter) {
     if (*iter == edge) {
-      dst->outGoing_.erase(iter);
+      dst->inGoing_.erase(iter);
       break;
     }
   }
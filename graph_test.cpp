@@ -11,7 +11,15 @@
   meets the specification.
 
 */
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <set>
+#include <sstream>
 #include <string>
+#include <type_traits>
 #include <utility>
 
 #include "assignments/dg/graph.h"
@@ -259,6 +267,213 @@ TEST_CASE("GetWeights") {
   }
 }
 
+TEST_CASE("Views") {
+  gdwg::Graph<int, int> g{3, 1, 2};
+  g.InsertEdge(1, 2, 5);
+  g.InsertEdge(1, 2, 3);
+  g.InsertEdge(1, 1, 7);
+  g.InsertEdge(3, 2, 1);
+  SECTION("Nodes in increasing order") {
+    std::vector<int> vec(g.Nodes().begin(), g.Nodes().end());
+    REQUIRE(vec == std::vector<int>{1, 2, 3});
+    REQUIRE(g.Nodes().size() == 3);
+    decltype(g.Nodes().begin()) unset;
+    unset = g.Nodes().begin();
+    REQUIRE(*unset == 1);
+  }
+  SECTION("OutEdges sorted by destination then weight") {
+    auto view = g.OutEdges(1);
+    REQUIRE(view.size() == 3);
+    auto it = view.begin();
+    REQUIRE(*it++ == std::make_tuple(1, 1, 7));
+    REQUIRE(*it++ == std::make_tuple(1, 2, 3));
+    REQUIRE(*it++ == std::make_tuple(1, 2, 5));
+    REQUIRE(it == view.end());
+  }
+  SECTION("InEdges sorted by source then weight") {
+    auto view = g.InEdges(2);
+    REQUIRE(view.size() == 3);
+    REQUIRE(view[0] == std::make_tuple(1, 2, 3));
+    REQUIRE(view[1] == std::make_tuple(1, 2, 5));
+    REQUIRE(view[2] == std::make_tuple(3, 2, 1));
+    REQUIRE(g.InEdges(3).empty());
+  }
+  SECTION("Edge and weight iterators support random access arithmetic") {
+    auto view = g.OutEdges(1);
+    decltype(view.begin()) unset;
+    unset = view.begin();
+    REQUIRE(unset == view.begin());
+    REQUIRE(view.end() > view.begin());
+    REQUIRE(view.begin() <= view.begin());
+    REQUIRE(view.end() >= view.begin() + 3);
+    REQUIRE(view.end() - view.begin() == 3);
+    auto weights = g.Weights(1, 2);
+    REQUIRE(*(weights.end() - 1) == 5);
+    REQUIRE(std::is_sorted(weights.begin(), weights.end()));
+    REQUIRE(*weights.begin().operator->() == 3);
+    using WeightCategory = std::iterator_traits<decltype(weights.begin())>::iterator_category;
+    using EdgeCategory = std::iterator_traits<decltype(view.begin())>::iterator_category;
+    REQUIRE(std::is_same_v<WeightCategory, std::random_access_iterator_tag>);
+    REQUIRE(std::is_same_v<EdgeCategory, std::input_iterator_tag>);
+  }
+  SECTION("Weights only covers the given destination") {
+    auto view = g.Weights(1, 2);
+    REQUIRE(std::vector<int>(view.begin(), view.end()) == std::vector<int>{3, 5});
+    REQUIRE(g.Weights(2, 1).empty());
+  }
+  SECTION("InEdges follow erase and DeleteNode") {
+    g.erase(1, 2, 3);
+    REQUIRE(g.InEdges(2).size() == 2);
+    g.DeleteNode(1);
+    REQUIRE(g.InEdges(2).size() == 1);
+  }
+  SECTION("Missing node throws exception") {
+    REQUIRE_THROWS_AS(g.OutEdges(6), std::out_of_range);
+    REQUIRE_THROWS_AS(g.InEdges(6), std::out_of_range);
+    REQUIRE_THROWS_AS(g.Weights(1, 6), std::out_of_range);
+  }
+}
+
+TEST_CASE("ForEachEdge & ForEachNode") {
+  // Node 0 has most of the edges so chunks must split its edge list.
+  gdwg::Graph<int, int> g;
+  for (int i = 0; i < 50; i++) {
+    g.InsertNode(i);
+  }
+  for (int i = 0; i < 50; i++) {
+    for (int w = 0; w < 20; w++) {
+      g.InsertEdge(0, i, w);
+    }
+    g.InsertEdge(i, 0, 100 + i);
+  }
+  long seqSum = 0;
+  int seqCount = 0;
+  g.ForEachEdge(gdwg::seq, [&](int src, int dst, int w) {
+    seqSum += src * 10000 + dst * 100 + w;
+    seqCount++;
+  });
+  REQUIRE(seqCount == 1050);
+  SECTION("Parallel visits every edge once") {
+    std::atomic<long> sum{0};
+    std::atomic<int> count{0};
+    g.ForEachEdge(gdwg::parallel_policy{4, 7}, [&](int src, int dst, int w) {
+      sum += src * 10000 + dst * 100 + w;
+      count++;
+    });
+    REQUIRE(count == seqCount);
+    REQUIRE(sum == seqSum);
+  }
+  SECTION("Parallel visits every node once") {
+    std::atomic<int> sum{0};
+    std::atomic<int> count{0};
+    g.ForEachNode(gdwg::parallel_policy{3, 4}, [&](int n) {
+      sum += n;
+      count++;
+    });
+    REQUIRE(count == 50);
+    REQUIRE(sum == 49 * 50 / 2);
+  }
+  SECTION("Exceptions are rethrown") {
+    REQUIRE_THROWS_AS(g.ForEachEdge(gdwg::par,
+                                    [](int, int dst, int) {
+                                      if (dst == 3) {
+                                        throw std::runtime_error("stop");
+                                      }
+                                    }),
+                      std::runtime_error);
+  }
+  SECTION("Empty graph") {
+    gdwg::Graph<int, int> empty;
+    int count = 0;
+    empty.ForEachEdge(gdwg::par, [&](int, int, int) { count++; });
+    empty.ForEachNode(gdwg::par, [&](int) { count++; });
+    REQUIRE(count == 0);
+  }
+}
+
+// 1 -> 2 -> 4 -> 5
+// 1 -> 3 -> 4, 3 -> 3, and 6 is unreachable
+TEST_CASE("Lazy traversals") {
+  gdwg::Graph<int, int> g{1, 2, 3, 4, 5, 6};
+  g.InsertEdge(1, 2, 1);
+  g.InsertEdge(1, 3, 1);
+  g.InsertEdge(2, 4, 1);
+  g.InsertEdge(3, 4, 1);
+  g.InsertEdge(3, 4, 2);
+  g.InsertEdge(3, 3, 1);
+  g.InsertEdge(4, 5, 1);
+  SECTION("Dfs visits reachable nodes in depth first order") {
+    std::vector<int> vec;
+    for (const auto& n : g.Dfs(1)) {
+      vec.push_back(n);
+    }
+    REQUIRE(vec == std::vector<int>{1, 2, 4, 5, 3});
+  }
+  SECTION("Bfs visits reachable nodes in breadth first order") {
+    std::vector<int> vec;
+    for (const auto& n : g.Bfs(1)) {
+      vec.push_back(n);
+    }
+    REQUIRE(vec == std::vector<int>{1, 2, 3, 4, 5});
+  }
+  SECTION("Pruned nodes are yielded but not expanded") {
+    std::vector<int> vec;
+    for (const auto& n : g.Dfs(1, [](int n) { return n == 2; })) {
+      vec.push_back(n);
+    }
+    REQUIRE(vec == std::vector<int>{1, 2, 3, 4, 5});
+    vec.clear();
+    for (const auto& n : g.Bfs(1, [](int n) { return n == 4; })) {
+      vec.push_back(n);
+    }
+    REQUIRE(vec == std::vector<int>{1, 2, 3, 4});
+  }
+  SECTION("Stopping early skips the rest of the traversal") {
+    int pruneCalls = 0;
+    auto dfs = g.Dfs(1, [&](int) {
+      pruneCalls++;
+      return false;
+    });
+    auto it = dfs.begin();
+    REQUIRE(*it == 1);
+    ++it;
+    REQUIRE(*it == 2);
+    REQUIRE(pruneCalls == 2);
+  }
+  SECTION("Paths enumerates simple paths once despite parallel edges") {
+    std::vector<std::vector<int>> paths;
+    for (const auto& path : g.Paths(1, 5, 3)) {
+      paths.emplace_back(path.begin(), path.end());
+    }
+    REQUIRE(paths == std::vector<std::vector<int>>{{1, 2, 4, 5}, {1, 3, 4, 5}});
+  }
+  SECTION("Paths respects maxLen") {
+    int count = 0;
+    for (const auto& path : g.Paths(1, 5, 2)) {
+      count += static_cast<int>(path.size());
+    }
+    REQUIRE(count == 0);
+    std::vector<std::vector<int>> paths;
+    for (const auto& path : g.Paths(1, 4, 2)) {
+      paths.emplace_back(path.begin(), path.end());
+    }
+    REQUIRE(paths == std::vector<std::vector<int>>{{1, 2, 4}, {1, 3, 4}});
+  }
+  SECTION("Path from a node to itself") {
+    std::vector<std::vector<int>> paths;
+    for (const auto& path : g.Paths(3, 3, 4)) {
+      paths.emplace_back(path.begin(), path.end());
+    }
+    REQUIRE(paths == std::vector<std::vector<int>>{{3}});
+  }
+  SECTION("Unreachable and missing nodes") {
+    REQUIRE(g.Paths(1, 6, 5).begin() == g.Paths(1, 6, 5).end());
+    REQUIRE_THROWS_AS(g.Dfs(7), std::out_of_range);
+    REQUIRE_THROWS_AS(g.Bfs(7), std::out_of_range);
+    REQUIRE_THROWS_AS(g.Paths(1, 7, 2), std::out_of_range);
+  }
+}
+
 TEST_CASE("Find iterator") {
   gdwg::Graph<int, int> g{1};
   g.InsertEdge(1, 1, 4);
@@ -431,6 +646,105 @@ TEST_CASE("Iterators2") {
   }
 }
 
+TEST_CASE("Export") {
+  gdwg::Graph<std::string, double> g{"a", "b", "c", "q\"x"};
+  g.InsertEdge("a", "b", 1.5);
+  g.InsertEdge("a", "a", -2);
+  g.InsertEdge("b", "c", 3);
+  g.InsertEdge("c", "q\"x", 4);
+  gdwg::Graph<std::string, double>::export_options options;
+  SECTION("Edge list") {
+    std::ostringstream os;
+    g.Export(os, options);
+    REQUIRE(os.str() == "a a -2\na b 1.5\nb c 3\nc q\"x 4\n");
+  }
+  SECTION("Filter by node set") {
+    std::set<std::string> keep{"a", "b"};
+    options.filter = [&](const std::string& n) { return keep.count(n) > 0; };
+    std::ostringstream os;
+    g.Export(os, options);
+    REQUIRE(os.str() == "a a -2\na b 1.5\n");
+  }
+  SECTION("Floating point weights round-trip") {
+    g.InsertEdge("b", "b", 0.1 + 0.2);
+    g.InsertEdge("c", "c", 1234567.0);
+    options.filter = [](const std::string& n) { return n != "a"; };
+    std::ostringstream os;
+    g.Export(os, options);
+    REQUIRE(os.str() == "b b 0.30000000000000004\nb c 3\nc c 1234567\nc q\"x 4\n");
+  }
+  SECTION("DOT") {
+    options.format = gdwg::export_format::kDot;
+    options.filter = [](const std::string& n) { return n != "a"; };
+    std::ostringstream os;
+    g.Export(os, options);
+    REQUIRE(os.str() == "digraph {\n"
+                        "  \"b\";\n"
+                        "  \"b\" -> \"c\" [label=\"3\"];\n"
+                        "  \"c\";\n"
+                        "  \"c\" -> \"q\\\"x\" [label=\"4\"];\n"
+                        "  \"q\\\"x\";\n"
+                        "}\n");
+  }
+  SECTION("Binary") {
+    gdwg::Graph<int, int> small{1, 2};
+    small.InsertEdge(1, 2, 7);
+    gdwg::Graph<int, int>::export_options binOptions;
+    binOptions.format = gdwg::export_format::kBinary;
+    std::ostringstream os;
+    small.Export(os, binOptions);
+    auto out = os.str();
+    REQUIRE(out.size() == 5 + (4 + 4 + 4 + 4) + (4 + 4));
+    REQUIRE(out.substr(0, 5) == std::string("GDWG\x01", 5));
+    std::int32_t values[6];
+    std::memcpy(values, out.data() + 5, sizeof(values));
+    REQUIRE(values[0] == 1);
+    REQUIRE(values[1] == 1);
+    REQUIRE(values[2] == 2);
+    REQUIRE(values[3] == 7);
+    REQUIRE(values[4] == 2);
+    REQUIRE(values[5] == 0);
+  }
+  SECTION("Parallel export matches sequential export") {
+    gdwg::Graph<int, int> big;
+    for (int i = 0; i < 200; i++) {
+      big.InsertNode(i);
+    }
+    for (int i = 0; i < 200; i++) {
+      for (int j = 0; j < i % 7; j++) {
+        big.InsertEdge(i, (i * 31 + j) % 200, j);
+      }
+    }
+    for (auto format : {gdwg::export_format::kEdgeList, gdwg::export_format::kDot,
+                        gdwg::export_format::kBinary}) {
+      gdwg::Graph<int, int>::export_options seqOptions;
+      seqOptions.format = format;
+      auto parOptions = seqOptions;
+      parOptions.policy = gdwg::parallel_policy{4, 5};
+      std::ostringstream seqOs, parOs;
+      big.Export(seqOs, seqOptions);
+      big.Export(parOs, parOptions);
+      REQUIRE(seqOs.str() == parOs.str());
+    }
+  }
+  SECTION("Parallel export rethrows from the filter") {
+    gdwg::Graph<int, int> big;
+    for (int i = 0; i < 100; i++) {
+      big.InsertNode(i);
+    }
+    gdwg::Graph<int, int>::export_options parOptions;
+    parOptions.policy = gdwg::parallel_policy{4, 1};
+    parOptions.filter = [](const int& n) {
+      if (n == 50) {
+        throw std::runtime_error("filter");
+      }
+      return true;
+    };
+    std::ostringstream os;
+    REQUIRE_THROWS_AS(big.Export(os, parOptions), std::runtime_error);
+  }
+}
+
 // ========================== Friends Test ==========================
 
 TEST_CASE("Operator == & !=") {
@@ -451,3 +765,107 @@ TEST_CASE("Operator == & !=") {
     REQUIRE(g != gCopy);
   }
 }
+
+TEST_CASE("Operator == compares edges") {
+  gdwg::Graph<std::string, int> g{"a", "b"};
+  g.InsertEdge("a", "b", 1);
+  gdwg::Graph<std::string, int> other{"a", "b"};
+  SECTION("Same nodes but different edges") {
+    other.InsertEdge("b", "a", 1);
+    REQUIRE(g != other);
+  }
+  SECTION("Same edges with different weights") {
+    other.InsertEdge("a", "b", 2);
+    REQUIRE(g != other);
+  }
+  SECTION("Equal graphs built in a different order") {
+    other.InsertEdge("a", "b", 5);
+    other.InsertEdge("a", "b", 1);
+    other.erase("a", "b", 5);
+    REQUIRE(g == other);
+  }
+}
+
+TEST_CASE("Fingerprint") {
+  gdwg::Graph<std::string, int> g{"a", "b", "c"};
+  g.InsertEdge("a", "b", 1);
+  g.InsertEdge("b", "b", 2);
+  g.InsertEdge("c", "a", 3);
+  gdwg::Graph<std::string, int> same{"c", "b", "a"};
+  same.InsertEdge("c", "a", 3);
+  same.InsertEdge("b", "b", 2);
+  same.InsertEdge("a", "b", 1);
+  SECTION("Equal graphs have equal fingerprints") {
+    REQUIRE(g.Fingerprint() == same.Fingerprint());
+    REQUIRE(std::hash<gdwg::Graph<std::string, int>>{}(g) == g.Fingerprint());
+  }
+  SECTION("Copies keep the fingerprint and are independent") {
+    gdwg::Graph<std::string, int> copy{g};
+    REQUIRE(copy.Fingerprint() == g.Fingerprint());
+    copy.InsertEdge("a", "c", 4);
+    REQUIRE(copy.Fingerprint() != g.Fingerprint());
+    REQUIRE(!g.IsConnected("a", "c"));
+  }
+  SECTION("Mutations are undone") {
+    auto before = g.Fingerprint();
+    g.InsertNode("d");
+    g.InsertEdge("d", "a", 1);
+    REQUIRE(g.Fingerprint() != before);
+    g.DeleteNode("d");
+    REQUIRE(g.Fingerprint() == before);
+    g.InsertEdge("a", "c", 4);
+    g.erase("a", "c", 4);
+    REQUIRE(g.Fingerprint() == before);
+  }
+  SECTION("Deleting a node with a self edge") {
+    g.DeleteNode("b");
+    same.erase("a", "b", 1);
+    same.erase("b", "b", 2);
+    same.DeleteNode("b");
+    REQUIRE(g.Fingerprint() == same.Fingerprint());
+    REQUIRE(g == same);
+  }
+  SECTION("Replace matches a graph built from scratch") {
+    g.Replace("c", "d");
+    gdwg::Graph<std::string, int> expected{"a", "b", "d"};
+    expected.InsertEdge("a", "b", 1);
+    expected.InsertEdge("b", "b", 2);
+    expected.InsertEdge("d", "a", 3);
+    REQUIRE(g.Fingerprint() == expected.Fingerprint());
+    REQUIRE(g == expected);
+  }
+  SECTION("Clear resets to an empty graph") {
+    g.Clear();
+    REQUIRE(g.Fingerprint() == gdwg::Graph<std::string, int>{}.Fingerprint());
+  }
+}
+
+// Can be a node value but has no std::hash.
+struct Unhashable {
+  int id;
+  friend bool operator<(const Unhashable& lhs, const Unhashable& rhs) { return lhs.id < rhs.id; }
+  friend bool operator==(const Unhashable& lhs, const Unhashable& rhs) { return lhs.id == rhs.id; }
+  friend bool operator!=(const Unhashable& lhs, const Unhashable& rhs) { return !(lhs == rhs); }
+  friend std::ostream& operator<<(std::ostream& os, const Unhashable& val) { return os << val.id; }
+};
+
+TEST_CASE("Fingerprint without std::hash") {
+  gdwg::Graph<Unhashable, int> g{Unhashable{1}, Unhashable{2}};
+  gdwg::Graph<Unhashable, int> other{Unhashable{3}, Unhashable{4}};
+  g.InsertEdge(Unhashable{1}, Unhashable{2}, 5);
+  other.InsertEdge(Unhashable{3}, Unhashable{4}, 5);
+  SECTION("Only counts and hashable values are fingerprinted") {
+    REQUIRE(g.Fingerprint() == other.Fingerprint());
+    REQUIRE(g != other);
+  }
+  SECTION("Hashable weights still change the fingerprint") {
+    other.erase(Unhashable{3}, Unhashable{4}, 5);
+    other.InsertEdge(Unhashable{3}, Unhashable{4}, 6);
+    REQUIRE(g.Fingerprint() != other.Fingerprint());
+  }
+  SECTION("std::hash of the graph is disabled") {
+    REQUIRE(!gdwg::detail::kIsHashable<gdwg::Graph<Unhashable, int>>);
+    REQUIRE(!gdwg::detail::kIsHashable<gdwg::Graph<int, Unhashable>>);
+    REQUIRE(gdwg::detail::kIsHashable<gdwg::Graph<int, int>>);
+  }
+}
@@ -0,0 +1,111 @@
+#ifndef ASSIGNMENTS_DG_PARTITIONED_GRAPH_H_
+#define ASSIGNMENTS_DG_PARTITIONED_GRAPH_H_
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "assignments/dg/graph.h"
+
+namespace gdwg {
+
+// A graph split into shards, each an ordinary gdwg::Graph. Every node is owned by exactly
+// one shard, chosen by the partitioner. An edge between two shards is stored in both: each
+// side keeps a ghost copy of the remote endpoint, reference counted by the number of
+// boundary edges that use it, so every shard can be traversed and exported on its own.
+template <typename N, typename E>
+class PartitionedGraph {
+ public:
+  using partitioner = std::function<std::size_t(const N&)>;
+
+  // Mutations grouped for Apply. Whatever order they are added in, a batch deletes nodes,
+  // then inserts nodes, then erases edges, then inserts edges.
+  class batch {
+   public:
+    void InsertNode(const N& val) { insertNodes_.push_back(val); }
+    void DeleteNode(const N& val) { deleteNodes_.push_back(val); }
+    void InsertEdge(const N& src, const N& dst, const E& w) {
+      insertEdges_.emplace_back(src, dst, w);
+    }
+    void EraseEdge(const N& src, const N& dst, const E& w) {
+      eraseEdges_.emplace_back(src, dst, w);
+    }
+
+   private:
+    std::vector<N> insertNodes_;
+    std::vector<N> deleteNodes_;
+    std::vector<std::tuple<N, N, E>> insertEdges_;
+    std::vector<std::tuple<N, N, E>> eraseEdges_;
+
+    friend class PartitionedGraph;
+  };
+
+  // ---------------------- Constructors ----------------------
+
+  // Hash partitioning over numShards shards.
+  explicit PartitionedGraph(std::size_t numShards);
+  // Range partitioning: shard i holds nodes in [bounds[i - 1], bounds[i]), giving
+  // bounds.size() + 1 shards. Throws std::runtime_error if bounds isn't sorted.
+  explicit PartitionedGraph(std::vector<N> bounds);
+  // partition must return a value below numShards for every node.
+  PartitionedGraph(std::size_t numShards, partitioner partition);
+
+  // ---------------------- Methods ----------------------
+  bool InsertNode(const N& val);
+  bool InsertEdge(const N& src, const N& dst, const E& w);
+  bool DeleteNode(const N& val);
+  bool erase(const N& src, const N& dst, const E& w);
+
+  // Routes each mutation to the shards it touches, then applies every shard's messages on
+  // its own thread, one kind of mutation at a time. Throws std::runtime_error without
+  // changing anything if an inserted edge would be missing an endpoint.
+  void Apply(const batch& b, const parallel_policy& policy = par);
+
+  bool IsNode(const N& val) const;
+  bool IsGhost(std::size_t shard, const N& val) const;
+  std::size_t NumShards() const;
+  std::size_t ShardOf(const N& val) const;
+  const Graph<N, E>& Shard(std::size_t shard) const;
+
+  // Writes the nodes owned by shard i, and the edges leaving them, to "<prefix>.<i>", so
+  // each edge appears in exactly one file. Ghosts are only written as the dst of a boundary
+  // edge, never as nodes of their own. Shards are written concurrently.
+  void ExportShards(const std::string& prefix,
+                    const typename Graph<N, E>::export_options& options = {},
+                    const parallel_policy& policy = par) const;
+
+ private:
+  struct ShardData {
+    Graph<N, E> graph;
+    std::map<N, std::size_t> ghosts;
+  };
+
+  // Per-shard message queues filled by Apply before any shard is touched.
+  struct Inbox {
+    std::vector<N> deleteOwned;
+    std::vector<N> deleteGhosts;
+    std::vector<N> insertNodes;
+    std::vector<std::tuple<N, N, E>> eraseEdges;
+    std::vector<std::tuple<N, N, E>> insertEdges;
+  };
+
+  partitioner partition_;
+  std::vector<ShardData> shards_;
+
+  std::vector<std::size_t> RemoteShards(const N& val) const;
+
+  bool ShardInsertEdge(std::size_t shard, const N& src, const N& dst, const E& w);
+  bool ShardEraseEdge(std::size_t shard, const N& src, const N& dst, const E& w);
+  bool ShardDeleteOwned(std::size_t shard, const N& val);
+  void ShardDeleteGhost(std::size_t shard, const N& val);
+  void ReleaseGhost(std::size_t shard, const N& val);
+};
+
+}  // namespace gdwg
+
+#include "assignments/dg/partitioned_graph.tpp"
+
+#endif  // ASSIGNMENTS_DG_PARTITIONED_GRAPH_H_
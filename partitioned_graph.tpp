@@ -0,0 +1,313 @@
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+// ---------------------- Constructors ----------------------
+template <typename N, typename E>
+gdwg::PartitionedGraph<N, E>::PartitionedGraph(std::size_t numShards)
+  : PartitionedGraph(numShards, [numShards](const N& val) {
+      return detail::Mix(detail::HashOf(val)) % numShards;
+    }) {
+  static_assert(detail::kIsHashable<N>,
+                "Hash partitioning needs std::hash<N>; pass bounds or a partitioner instead");
+}
+
+template <typename N, typename E>
+gdwg::PartitionedGraph<N, E>::PartitionedGraph(std::vector<N> bounds)
+  : PartitionedGraph(bounds.size() + 1, [bounds](const N& val) {
+      return static_cast<std::size_t>(std::upper_bound(bounds.begin(), bounds.end(), val) -
+                                      bounds.begin());
+    }) {
+  if (!std::is_sorted(bounds.begin(), bounds.end())) {
+    throw std::runtime_error("Cannot construct a PartitionedGraph with unsorted bounds");
+  }
+}
+
+template <typename N, typename E>
+gdwg::PartitionedGraph<N, E>::PartitionedGraph(std::size_t numShards, partitioner partition)
+  : partition_{std::move(partition)} {
+  if (numShards == 0) {
+    throw std::runtime_error("Cannot construct a PartitionedGraph with no shards");
+  }
+  shards_.resize(numShards);
+}
+
+// ---------------------- Methods ----------------------
+template <typename N, typename E>
+bool gdwg::PartitionedGraph<N, E>::InsertNode(const N& val) {
+  return shards_[ShardOf(val)].graph.InsertNode(val);
+}
+
+template <typename N, typename E>
+bool gdwg::PartitionedGraph<N, E>::InsertEdge(const N& src, const N& dst, const E& w) {
+  if (!IsNode(src) || !IsNode(dst)) {
+    throw std::runtime_error("Cannot call PartitionedGraph::InsertEdge when either src or "
+                             "dst node does not exist");
+  }
+  auto srcShard = ShardOf(src);
+  auto dstShard = ShardOf(dst);
+  bool inserted = ShardInsertEdge(srcShard, src, dst, w);
+  if (inserted && srcShard != dstShard) {
+    ShardInsertEdge(dstShard, src, dst, w);
+  }
+  return inserted;
+}
+
+template <typename N, typename E>
+bool gdwg::PartitionedGraph<N, E>::DeleteNode(const N& val) {
+  if (!IsNode(val)) {
+    return false;
+  }
+  auto remotes = RemoteShards(val);
+  ShardDeleteOwned(ShardOf(val), val);
+  for (auto shard : remotes) {
+    ShardDeleteGhost(shard, val);
+  }
+  return true;
+}
+
+template <typename N, typename E>
+bool gdwg::PartitionedGraph<N, E>::erase(const N& src, const N& dst, const E& w) {
+  auto srcShard = ShardOf(src);
+  auto dstShard = ShardOf(dst);
+  bool erased = ShardEraseEdge(srcShard, src, dst, w);
+  if (erased && srcShard != dstShard) {
+    ShardEraseEdge(dstShard, src, dst, w);
+  }
+  return erased;
+}
+
+template <typename N, typename E>
+void gdwg::PartitionedGraph<N, E>::Apply(const batch& b, const parallel_policy& policy) {
+  std::set<N> deleted(b.deleteNodes_.begin(), b.deleteNodes_.end());
+  std::set<N> inserted(b.insertNodes_.begin(), b.insertNodes_.end());
+  auto willExist = [&](const N& val) {
+    return inserted.count(val) > 0 || (deleted.count(val) == 0 && IsNode(val));
+  };
+  for (const auto& [src, dst, w] : b.insertEdges_) {
+    if (!willExist(src) || !willExist(dst)) {
+      throw std::runtime_error("Cannot call PartitionedGraph::Apply when either src or dst "
+                               "node of an inserted edge does not exist");
+    }
+  }
+
+  std::vector<Inbox> inboxes(shards_.size());
+  for (const auto& val : b.deleteNodes_) {
+    if (!IsNode(val)) {
+      continue;
+    }
+    inboxes[ShardOf(val)].deleteOwned.push_back(val);
+    for (auto shard : RemoteShards(val)) {
+      inboxes[shard].deleteGhosts.push_back(val);
+    }
+  }
+  for (const auto& val : b.insertNodes_) {
+    inboxes[ShardOf(val)].insertNodes.push_back(val);
+  }
+  auto routeEdge = [&](const std::tuple<N, N, E>& edge,
+                       std::vector<std::tuple<N, N, E>> Inbox::*queue) {
+    auto srcShard = ShardOf(std::get<0>(edge));
+    auto dstShard = ShardOf(std::get<1>(edge));
+    (inboxes[srcShard].*queue).push_back(edge);
+    if (srcShard != dstShard) {
+      (inboxes[dstShard].*queue).push_back(edge);
+    }
+  };
+  for (const auto& edge : b.eraseEdges_) {
+    routeEdge(edge, &Inbox::eraseEdges);
+  }
+  for (const auto& edge : b.insertEdges_) {
+    routeEdge(edge, &Inbox::insertEdges);
+  }
+
+  // Each step only touches shards_[shard], so the shards can run in parallel.
+  detail::RunChunks(policy, shards_.size(), [&](std::size_t shard) {
+    for (const auto& val : inboxes[shard].deleteOwned) {
+      ShardDeleteOwned(shard, val);
+    }
+    for (const auto& val : inboxes[shard].deleteGhosts) {
+      ShardDeleteGhost(shard, val);
+    }
+  });
+  detail::RunChunks(policy, shards_.size(), [&](std::size_t shard) {
+    for (const auto& val : inboxes[shard].insertNodes) {
+      shards_[shard].graph.InsertNode(val);
+    }
+  });
+  detail::RunChunks(policy, shards_.size(), [&](std::size_t shard) {
+    for (const auto& [src, dst, w] : inboxes[shard].eraseEdges) {
+      ShardEraseEdge(shard, src, dst, w);
+    }
+  });
+  detail::RunChunks(policy, shards_.size(), [&](std::size_t shard) {
+    for (const auto& [src, dst, w] : inboxes[shard].insertEdges) {
+      ShardInsertEdge(shard, src, dst, w);
+    }
+  });
+}
+
+template <typename N, typename E>
+bool gdwg::PartitionedGraph<N, E>::IsNode(const N& val) const {
+  return shards_[ShardOf(val)].graph.IsNode(val);
+}
+
+template <typename N, typename E>
+bool gdwg::PartitionedGraph<N, E>::IsGhost(std::size_t shard, const N& val) const {
+  return shards_.at(shard).ghosts.count(val) > 0;
+}
+
+template <typename N, typename E>
+std::size_t gdwg::PartitionedGraph<N, E>::NumShards() const {
+  return shards_.size();
+}
+
+template <typename N, typename E>
+std::size_t gdwg::PartitionedGraph<N, E>::ShardOf(const N& val) const {
+  auto shard = partition_(val);
+  if (shard >= shards_.size()) {
+    throw std::out_of_range("PartitionedGraph partitioner returned a shard that doesn't exist");
+  }
+  return shard;
+}
+
+template <typename N, typename E>
+const gdwg::Graph<N, E>& gdwg::PartitionedGraph<N, E>::Shard(std::size_t shard) const {
+  return shards_.at(shard).graph;
+}
+
+template <typename N, typename E>
+void gdwg::PartitionedGraph<N, E>::ExportShards(
+    const std::string& prefix,
+    const typename Graph<N, E>::export_options& options,
+    const parallel_policy& policy) const {
+  detail::RunChunks(policy, shards_.size(), [&](std::size_t shard) {
+    const auto& ghosts = shards_[shard].ghosts;
+    auto shardOptions = options;
+    shardOptions.filter = [&](const N& val) {
+      return ghosts.count(val) == 0 && (!options.filter || options.filter(val));
+    };
+    shardOptions.dstFilter = [&](const N& val) { return !options.filter || options.filter(val); };
+    auto path = prefix + "." + std::to_string(shard);
+    std::ofstream file(path, std::ios::binary);
+    if (file) {
+      shards_[shard].graph.Export(file, shardOptions);
+    }
+    if (!file) {
+      throw std::runtime_error("Cannot write PartitionedGraph shard to " + path);
+    }
+  });
+}
+
+// Shards other than val's owner that hold a ghost of val.
+template <typename N, typename E>
+std::vector<std::size_t> gdwg::PartitionedGraph<N, E>::RemoteShards(const N& val) const {
+  const auto& owner = shards_[ShardOf(val)];
+  std::vector<std::size_t> remotes;
+  for (const auto& [src, dst, w] : owner.graph.OutEdges(val)) {
+    if (owner.ghosts.count(dst) > 0) {
+      remotes.push_back(ShardOf(dst));
+    }
+  }
+  for (const auto& [src, dst, w] : owner.graph.InEdges(val)) {
+    if (owner.ghosts.count(src) > 0) {
+      remotes.push_back(ShardOf(src));
+    }
+  }
+  std::sort(remotes.begin(), remotes.end());
+  remotes.erase(std::unique(remotes.begin(), remotes.end()), remotes.end());
+  return remotes;
+}
+
+template <typename N, typename E>
+bool gdwg::PartitionedGraph<N, E>::ShardInsertEdge(std::size_t shard,
+                                                   const N& src,
+                                                   const N& dst,
+                                                   const E& w) {
+  auto& data = shards_[shard];
+  std::vector<const N*> remote;
+  for (const auto* val : {&src, &dst}) {
+    if (ShardOf(*val) != shard) {
+      remote.push_back(val);
+      if (data.graph.InsertNode(*val)) {
+        data.ghosts[*val] = 0;
+      }
+    }
+  }
+  bool inserted = data.graph.InsertEdge(src, dst, w);
+  for (const auto* val : remote) {
+    if (inserted) {
+      ++data.ghosts[*val];
+    } else if (data.ghosts[*val] == 0) {
+      data.graph.DeleteNode(*val);
+      data.ghosts.erase(*val);
+    }
+  }
+  return inserted;
+}
+
+template <typename N, typename E>
+bool gdwg::PartitionedGraph<N, E>::ShardEraseEdge(std::size_t shard,
+                                                  const N& src,
+                                                  const N& dst,
+                                                  const E& w) {
+  if (!shards_[shard].graph.erase(src, dst, w)) {
+    return false;
+  }
+  for (const auto* val : {&src, &dst}) {
+    if (ShardOf(*val) != shard) {
+      ReleaseGhost(shard, *val);
+    }
+  }
+  return true;
+}
+
+template <typename N, typename E>
+bool gdwg::PartitionedGraph<N, E>::ShardDeleteOwned(std::size_t shard, const N& val) {
+  auto& data = shards_[shard];
+  if (!data.graph.IsNode(val)) {
+    return false;
+  }
+  std::vector<N> ghosts;
+  for (const auto& [src, dst, w] : data.graph.OutEdges(val)) {
+    if (data.ghosts.count(dst) > 0) {
+      ghosts.push_back(dst);
+    }
+  }
+  for (const auto& [src, dst, w] : data.graph.InEdges(val)) {
+    if (data.ghosts.count(src) > 0) {
+      ghosts.push_back(src);
+    }
+  }
+  data.graph.DeleteNode(val);
+  for (const auto& ghost : ghosts) {
+    ReleaseGhost(shard, ghost);
+  }
+  return true;
+}
+
+template <typename N, typename E>
+void gdwg::PartitionedGraph<N, E>::ShardDeleteGhost(std::size_t shard, const N& val) {
+  auto& data = shards_[shard];
+  if (data.ghosts.erase(val) > 0) {
+    data.graph.DeleteNode(val);
+  }
+}
+
+template <typename N, typename E>
+void gdwg::PartitionedGraph<N, E>::ReleaseGhost(std::size_t shard, const N& val) {
+  auto& data = shards_[shard];
+  auto it = data.ghosts.find(val);
+  if (it == data.ghosts.end()) {
+    throw std::logic_error("PartitionedGraph lost track of a ghost's boundary edges");
+  }
+  if (--it->second == 0) {
+    data.ghosts.erase(it);
+    data.graph.DeleteNode(val);
+  }
+}
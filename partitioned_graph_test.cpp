@@ -0,0 +1,210 @@
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "assignments/dg/partitioned_graph.h"
+#include "catch.h"
+
+namespace {
+
+// Every edge once, from the shard that owns its source.
+std::vector<std::tuple<int, int, int>> AllEdges(const gdwg::PartitionedGraph<int, int>& pg) {
+  std::vector<std::tuple<int, int, int>> edges;
+  for (std::size_t s = 0; s < pg.NumShards(); s++) {
+    pg.Shard(s).ForEachEdge(gdwg::seq, [&](int src, int dst, int w) {
+      if (!pg.IsGhost(s, src)) {
+        edges.emplace_back(src, dst, w);
+      }
+    });
+  }
+  std::sort(edges.begin(), edges.end());
+  return edges;
+}
+
+}  // namespace
+
+TEST_CASE("Partitioning") {
+  SECTION("Range partitioning") {
+    gdwg::PartitionedGraph<int, int> pg{std::vector<int>{10, 20}};
+    REQUIRE(pg.NumShards() == 3);
+    REQUIRE(pg.ShardOf(5) == 0);
+    REQUIRE(pg.ShardOf(10) == 1);
+    REQUIRE(pg.ShardOf(25) == 2);
+  }
+  SECTION("Hash partitioning keeps nodes in their own shard") {
+    gdwg::PartitionedGraph<std::string, int> pg{4};
+    for (auto val : {"a", "b", "c", "d", "e", "f"}) {
+      REQUIRE(pg.InsertNode(val));
+      REQUIRE(pg.Shard(pg.ShardOf(val)).Nodes().size() > 0);
+    }
+    REQUIRE(!pg.InsertNode("a"));
+  }
+  SECTION("Bad partitioner throws exception") {
+    gdwg::PartitionedGraph<int, int> pg{2, [](int) { return std::size_t{5}; }};
+    REQUIRE_THROWS_AS(pg.InsertNode(1), std::out_of_range);
+    REQUIRE_THROWS_AS((gdwg::PartitionedGraph<int, int>{0}), std::runtime_error);
+    REQUIRE_THROWS_AS((gdwg::PartitionedGraph<int, int>{std::vector<int>{20, 10}}),
+                      std::runtime_error);
+  }
+}
+
+// Only has operator<, so it can be range partitioned but not hash partitioned.
+struct Version {
+  int major;
+  int minor;
+};
+bool operator<(const Version& lhs, const Version& rhs) {
+  return std::tie(lhs.major, lhs.minor) < std::tie(rhs.major, rhs.minor);
+}
+bool operator==(const Version& lhs, const Version& rhs) {
+  return std::tie(lhs.major, lhs.minor) == std::tie(rhs.major, rhs.minor);
+}
+bool operator!=(const Version& lhs, const Version& rhs) {
+  return !(lhs == rhs);
+}
+
+TEST_CASE("Partitioning values without std::hash") {
+  gdwg::PartitionedGraph<Version, int> pg{std::vector<Version>{{2, 0}}};
+  REQUIRE(pg.InsertNode({1, 4}));
+  REQUIRE(pg.InsertNode({2, 1}));
+  REQUIRE(pg.InsertEdge({1, 4}, {2, 1}, 3));
+  REQUIRE(pg.ShardOf({1, 4}) == 0);
+  REQUIRE(pg.ShardOf({2, 1}) == 1);
+  REQUIRE(pg.IsGhost(1, {1, 4}));
+  REQUIRE(pg.Shard(0).OutEdges({1, 4}).size() == 1);
+}
+
+// Shard 0 holds 1 and 2, shard 1 holds 11 and 12.
+TEST_CASE("Boundary edges") {
+  gdwg::PartitionedGraph<int, int> pg{std::vector<int>{10}};
+  for (int val : {1, 2, 11, 12}) {
+    pg.InsertNode(val);
+  }
+  REQUIRE(pg.InsertEdge(1, 2, 1));
+  REQUIRE(pg.InsertEdge(1, 11, 2));
+  REQUIRE(pg.InsertEdge(1, 11, 3));
+  REQUIRE(pg.InsertEdge(12, 2, 4));
+  SECTION("Cross shard edges are stored on both sides with ghosts") {
+    REQUIRE(pg.IsGhost(0, 11));
+    REQUIRE(pg.IsGhost(0, 12));
+    REQUIRE(pg.IsGhost(1, 1));
+    REQUIRE(pg.IsGhost(1, 2));
+    REQUIRE(pg.Shard(1).InEdges(11).size() == 2);
+    REQUIRE(!pg.InsertEdge(1, 11, 2));
+    REQUIRE(AllEdges(pg) == std::vector<std::tuple<int, int, int>>{
+                                {1, 2, 1}, {1, 11, 2}, {1, 11, 3}, {12, 2, 4}});
+  }
+  SECTION("Ghosts are dropped with their last boundary edge") {
+    REQUIRE(pg.erase(1, 11, 2));
+    REQUIRE(pg.IsGhost(0, 11));
+    REQUIRE(pg.erase(1, 11, 3));
+    REQUIRE(!pg.IsGhost(0, 11));
+    REQUIRE(!pg.IsGhost(1, 1));
+    REQUIRE(pg.IsGhost(1, 2));
+    REQUIRE(!pg.erase(1, 11, 3));
+  }
+  SECTION("Deleting a node removes its ghosts and boundary edges") {
+    REQUIRE(pg.DeleteNode(1));
+    REQUIRE(!pg.IsNode(1));
+    REQUIRE(!pg.IsGhost(1, 1));
+    REQUIRE(!pg.IsGhost(0, 11));
+    REQUIRE(pg.Shard(1).InEdges(11).empty());
+    REQUIRE(AllEdges(pg) == std::vector<std::tuple<int, int, int>>{{12, 2, 4}});
+  }
+  SECTION("Either node doesn't exist throws exception") {
+    REQUIRE_THROWS_AS(pg.InsertEdge(1, 13, 1), std::runtime_error);
+  }
+}
+
+TEST_CASE("Apply batch") {
+  gdwg::PartitionedGraph<int, int> pg{3};
+  gdwg::PartitionedGraph<int, int>::batch b;
+  gdwg::Graph<int, int> expected;
+  for (int i = 0; i < 60; i++) {
+    b.InsertNode(i);
+    expected.InsertNode(i);
+  }
+  for (int i = 0; i < 60; i++) {
+    for (int j = 1; j <= 3; j++) {
+      b.InsertEdge(i, (i * 7 + j) % 60, j);
+      expected.InsertEdge(i, (i * 7 + j) % 60, j);
+    }
+  }
+  pg.Apply(b, gdwg::parallel_policy{3, 0});
+  auto expectedEdges = [&]() {
+    std::vector<std::tuple<int, int, int>> edges;
+    expected.ForEachEdge(gdwg::seq,
+                         [&](int src, int dst, int w) { edges.emplace_back(src, dst, w); });
+    return edges;
+  };
+  SECTION("Matches an unpartitioned graph") { REQUIRE(AllEdges(pg) == expectedEdges()); }
+  SECTION("Deletes and erases in a later batch") {
+    gdwg::PartitionedGraph<int, int>::batch next;
+    for (int i = 0; i < 60; i += 5) {
+      next.DeleteNode(i);
+      expected.DeleteNode(i);
+    }
+    next.EraseEdge(1, 9, 2);
+    expected.erase(1, 9, 2);
+    next.InsertNode(100);
+    expected.InsertNode(100);
+    next.InsertEdge(100, 1, 1);
+    expected.InsertEdge(100, 1, 1);
+    pg.Apply(next, gdwg::parallel_policy{3, 0});
+    REQUIRE(AllEdges(pg) == expectedEdges());
+    REQUIRE(!pg.IsNode(5));
+    for (std::size_t s = 0; s < pg.NumShards(); s++) {
+      REQUIRE(!pg.IsGhost(s, 5));
+    }
+  }
+  SECTION("Invalid batch changes nothing") {
+    gdwg::PartitionedGraph<int, int>::batch bad;
+    bad.DeleteNode(1);
+    bad.InsertEdge(1, 2, 9);
+    REQUIRE_THROWS_AS(pg.Apply(bad), std::runtime_error);
+    REQUIRE(pg.IsNode(1));
+    REQUIRE(AllEdges(pg) == expectedEdges());
+  }
+}
+
+TEST_CASE("ExportShards") {
+  gdwg::PartitionedGraph<int, int> pg{std::vector<int>{10}};
+  pg.InsertNode(1);
+  pg.InsertNode(11);
+  pg.InsertEdge(1, 11, 5);
+  auto prefix = std::string("partitioned_graph_test_export");
+  auto readShards = [&]() {
+    std::vector<std::string> shards;
+    for (std::size_t s = 0; s < pg.NumShards(); s++) {
+      auto path = prefix + "." + std::to_string(s);
+      std::ifstream file(path);
+      std::stringstream contents;
+      contents << file.rdbuf();
+      shards.push_back(contents.str());
+      std::remove(path.c_str());
+    }
+    return shards;
+  };
+  SECTION("Boundary edges are written once, by the source's shard") {
+    pg.ExportShards(prefix);
+    REQUIRE(readShards() == std::vector<std::string>{"1 11 5\n", ""});
+  }
+  SECTION("Ghosts are not written as nodes") {
+    gdwg::Graph<int, int>::export_options options;
+    options.format = gdwg::export_format::kDot;
+    pg.ExportShards(prefix, options);
+    REQUIRE(readShards() == std::vector<std::string>{
+                                "digraph {\n  \"1\";\n  \"1\" -> \"11\" [label=\"5\"];\n}\n",
+                                "digraph {\n  \"11\";\n}\n"});
+  }
+  SECTION("Filter still applies to boundary edges") {
+    gdwg::Graph<int, int>::export_options options;
+    options.filter = [](const int& n) { return n != 11; };
+    pg.ExportShards(prefix, options);
+    REQUIRE(readShards() == std::vector<std::string>{"", ""});
+  }
+}